@@ -18,34 +18,100 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Esn.h"
 #include "EsnOpts.h"
+#include "EsnRandom.h"
+#include "EsnStream.h"
 
 #include <algorithm>
 #include <armadillo>
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <utility>
 #include <vector>
-#include <random>
 
 //_____________________________________________________________________________________________________________________
 
-void Esn::BuildNetwork( )
+void Esn::BuildBlockNetwork()
+{
+    // random, sparse blocks along the diagonal; last block takes the remainder //
+    int numBlocks = ( opts.reservoirSize + opts.blockSize - 1 ) / opts.blockSize;
+    weights.resBlocks.set_size( numBlocks );
+    weights.resMaxEigenvalue = 0.0;
+    for ( int b = 0; b < numBlocks; ++b ) {
+        int bsize = std::min( opts.blockSize, opts.reservoirSize - b*opts.blockSize );
+        int numZeroElements = std::round( bsize * bsize * (opts.sparsity) );
+        weights.resBlocks(b).set_size( bsize, bsize );
+        uint64_t offset = (uint64_t)b * opts.blockSize * opts.blockSize;
+        FillRandom( weights.resBlocks(b), resValuesStream, offset );
+        SparsifyRandom( weights.resBlocks(b), numZeroElements, offset );
+
+        // spectrum of a block-diagonal matrix is the union of the block spectra //
+        arma::cx_vec eigval; arma::cx_mat eigvec;
+        arma::eig_gen( eigval, eigvec, weights.resBlocks(b) );
+        arma::vec eigvalReal = arma::abs( arma::real( eigval ) );
+        weights.resMaxEigenvalue = std::max( weights.resMaxEigenvalue, (float)eigvalReal.max() );
+    }
+}
+//_____________________________________________________________________________________________________________________
+
+void Esn::BuildCycleNetwork()
+{
+    // unit weights around the cycle, optional bidirectional jumps weighted relative to the //
+    // cycle; -s only fixes the overall scale, so the jump/cycle ratio stays a free parameter //
+    weights.resJumpWeight = ( opts.topologyType == jumpTopology ) ? opts.jumpWeight : 0.0;
+    weights.resScale = 1.0;
+
+    if ( opts.topologyType == cycleTopology ) {
+        // eigenvalues of a unit cycle are the n-th roots of unity //
+        weights.resMaxEigenvalue = 1.0;
+        return;
+    }
+
+    // matrix is non-negative, so bound the Perron root of (W + I) with Collatz-Wielandt //
+    arma::vec v( opts.reservoirSize, arma::fill::ones );
+    double lo = 0.0, hi = 0.0;
+    for ( int it = 0; it < 10000; ++it ) {
+        arma::vec w = GetReservoirActivation( v ) + v;
+        arma::vec ratio = w / v;
+        lo = ratio.min();
+        hi = ratio.max();
+        v = w / arma::norm( w, "inf" );
+        if ( hi - lo < 1e-7 * hi ) {
+            break;
+        }
+    }
+    weights.resMaxEigenvalue = 0.5 * ( lo + hi ) - 1.0;
+}
+//_____________________________________________________________________________________________________________________
+
+void Esn::BuildNetwork( int networkIndex )
 {
     gridSize = opts.leakingRates.size() + opts.spectralRadii.size() + opts.regularizations.size() + opts.inputScalings.size();
+    weights.networkIndex = networkIndex;
 
-    // fill vector with random, sparse numbers and shuffle //
+    if ( opts.topologyType == cycleTopology || opts.topologyType == jumpTopology ) {
+        BuildCycleNetwork();
+    }
+    else if ( opts.topologyType == blockTopology ) {
+        BuildBlockNetwork();
+    }
+    else {
+        BuildRandomNetwork();
+    }
+
+    /// prepare input layer ///
+    weights.in.set_size( opts.reservoirSize, 2 );
+    FillRandom( weights.in, inValuesStream, 0 );
+} 
+//_____________________________________________________________________________________________________________________
+
+void Esn::BuildRandomNetwork()
+{
+    // fill reservoir with random, sparse numbers //
     int numZeroElements = std::round( opts.reservoirSize * opts.reservoirSize  * (opts.sparsity) );
-    std::random_device rd;
-    std::mt19937 gen(rd()); 
-    std::uniform_real_distribution<double> dist(-0.5, 0.5);
-    arma::vec vtemp( opts.reservoirSize * opts.reservoirSize );
-    vtemp.imbue( [&]() { return dist(gen); } );
-    vtemp.subvec(0, numZeroElements-1).fill(0.0);
-    vtemp = arma::shuffle( vtemp );
-
-    // copy to reservoir //
     weights.res.set_size( opts.reservoirSize, opts.reservoirSize );
-    weights.res = arma::reshape(vtemp, opts.reservoirSize, opts.reservoirSize );
+    FillRandom( weights.res, resValuesStream, 0 );
+    SparsifyRandom( weights.res, numZeroElements, 0 );
 
     // store largest eigenvalue  //
     arma::cx_vec eigval; arma::cx_mat eigvec;
@@ -53,11 +119,7 @@ void Esn::BuildNetwork( )
     arma::vec eigvalReal = arma::real( eigval );
     eigvalReal = arma::abs( eigvalReal );
     weights.resMaxEigenvalue = eigvalReal.max();
-
-    /// prepare input layer ///
-    weights.in.set_size( opts.reservoirSize, 2 );
-    weights.in.imbue( [&]() { return dist(gen); } );
-} 
+}
 //_____________________________________________________________________________________________________________________
 
 Esn::Esn( EsnOpts esnOpts ) 
@@ -66,10 +128,16 @@ Esn::Esn( EsnOpts esnOpts )
 }
 //_____________________________________________________________________________________________________________________
 
-void Esn::DriveNetwork( const arma::vec& input, bool shedRows )
+int Esn::DriveNetwork( const arma::vec& input, bool shedRows, float errorBound )
 {
     float leakingRate = GetLeakingRate();
 
+    // running sum of squared validation errors, one trial at a time //
+    int lastKept = trialLength - opts.steps - 2;
+    int numKeptPerTrial = lastKept - opts.washout + 1;
+    int numTrials = input.size() / trialLength;
+    double errorSum = 0.0;
+
     predicted.set_size( input.size() );
     predicted.fill( 0.0 );
    
@@ -81,20 +149,83 @@ void Esn::DriveNetwork( const arma::vec& input, bool shedRows )
     float vsize = input.size()-1;
     for ( int i = 0; i < vsize; ++i ) {
         vtemp1[1] = u;
-        x = (1 - leakingRate)*x + leakingRate * arma::tanh( weights.inScaled * vtemp1 + weights.resScaled * x );
+        x = (1 - leakingRate)*x + leakingRate * arma::tanh( weights.inScaled * vtemp1 + GetReservoirActivation( x ) );
         vtemp2[1] = u;
-        vtemp2.subvec(2, weights.x.n_rows-1) = x;
+        vtemp2.subvec(2, opts.reservoirSize+1) = x;
         predicted(i) = arma::conv_to< double >::from( weights.out*vtemp2 );
         u = input( i+1 );
+
+        if ( errorBound > 0 && i % trialLength == lastKept ) {
+            int trial = i / trialLength;
+            int i0 = trial*trialLength + opts.washout;
+            int t0 = trial*numKeptPerTrial;
+            errorSum += arma::accu( arma::square( dataValTarget.subvec( t0, t0+numKeptPerTrial-1 ) 
+                                                  - predicted.subvec( i0, i0+numKeptPerTrial-1 ) ) );
+            
+            // error can only grow with more trials, so this is a lower bound on the final NRMSE //
+            if ( trial < numTrials-1 && std::sqrt( errorSum/valTargetSumSquares ) * 100 >= errorBound ) {
+                return trial + 1;
+            }
+        }
     }
 
     vsize = vsize + 1;
     if ( shedRows ) {
         RemoveWashoutAndLastKPredictionsByRows( predicted, vsize, trialLength );
     }
+    return numTrials;
 } 
 //_____________________________________________________________________________________________________________________
 
+void Esn::DriveNetworkFreeRunning( const arma::vec& input )
+{
+    // one column per (epoch, start point), all driven together; unlike DriveNetwork, //
+    // each column starts from the initial state instead of the previous epoch's state //
+    float leakingRate = GetLeakingRate();
+    int numTrials = input.size() / trialLength;
+    int numStarts = opts.freeRunStarts.size();
+    int numCols = numTrials * numStarts;
+    int horizon = opts.steps - 1;
+
+    arma::mat x( opts.reservoirSize, numCols, arma::fill::ones );
+    arma::mat u( 2, numCols, arma::fill::ones );
+    arma::mat y( trialLength, numCols, arma::fill::zeros );
+    arma::mat outRes = weights.out.cols( 2, opts.reservoirSize+1 );
+
+    for ( int t = 0; t < trialLength; ++t ) {
+        for ( int e = 0; e < numTrials; ++e ) {
+            for ( int s = 0; s < numStarts; ++s ) {
+                int c = e*numStarts + s;
+                int tFree = t - opts.freeRunStarts[s];
+
+                // measured input before the start point and every resyncInterval steps after it, //
+                // otherwise the prediction made "horizon" steps earlier for this timepoint //
+                bool measured = tFree < 0 || t < horizon ||
+                                ( opts.resyncInterval > 0 && tFree > 0 && tFree % opts.resyncInterval == 0 );
+                u(1,c) = measured ? input( e*trialLength + t ) : y( t-horizon, c );
+            }
+        }
+        x = (1 - leakingRate)*x + leakingRate * arma::tanh( weights.inScaled * u + GetReservoirActivation( x ) );
+        y.row(t) = weights.out(0) + weights.out(1) * u.row(1) + outRes * x;
+    }
+
+    predicted = arma::vectorise( y );
+}
+//_____________________________________________________________________________________________________________________
+
+void Esn::FillRandom( arma::mat& m, uint32_t stream, uint64_t offset )
+{
+    // uniform on [-0.5, 0.5), element i always draws counter offset+i //
+    EsnRandom rng( opts.seed, weights.networkIndex, stream );
+    double* p = m.memptr();
+    long long numElements = m.n_elem;
+    #pragma omp parallel for
+    for ( long long i = 0; i < numElements; ++i ) {
+        p[i] = rng.Uniform( offset + i ) - 0.5;
+    }
+}
+//_____________________________________________________________________________________________________________________
+
 float Esn::GetBestInputScaling() { return weightsBest.opts[0]; }
 //_____________________________________________________________________________________________________________________
 
@@ -119,18 +250,46 @@ float Esn::GetLeakingRate() { return weights.opts[2]; }
 void Esn::GetOutputWeights()
 {
     float regularization = GetRegularization();
-    arma::mat identityMatrix( opts.reservoirSize+2, opts.reservoirSize+2, arma::fill::eye );
 
-    //weights.out = dataTrainTarget.t() * weights.x.t() * arma::inv( weights.x * weights.x.t() 
-    //               + regularization*identityMatrix );
-
-    arma::mat m1 = weights.x * weights.x.t() + regularization * identityMatrix;
-    arma::mat m2 = weights.x * dataTrainTarget;
-    arma::mat m3 = arma::solve( m1, m2 );
+    // only the upper triangle of the gram matrix is accumulated //
+    arma::mat m1 = arma::symmatu( stateGram );
+    m1.diag() += regularization;
+    arma::mat m3 = arma::solve( m1, stateTargetProduct );
     weights.out = m3.t();
 }
 //_____________________________________________________________________________________________________________________
 
+arma::mat Esn::GetReservoirActivation( const arma::mat& x )
+{
+    if ( opts.topologyType == randomTopology ) {
+        return weights.resScaled * x;
+    }
+
+    // each column is an independent reservoir state //
+    int n = x.n_rows;
+    arma::mat rx( n, x.n_cols );
+    if ( opts.topologyType == blockTopology ) {
+        for ( int b = 0, r = 0; b < (int)weights.resBlocks.n_elem; ++b ) {
+            int bsize = weights.resBlocks(b).n_rows;
+            rx.rows( r, r+bsize-1 ) = weights.resBlocks(b) * x.rows( r, r+bsize-1 );
+            r += bsize;
+        }
+        return weights.resScale * rx;
+    }
+
+    // unit i receives from unit i-1 around the cycle //
+    rx.row(0) = x.row(n-1);
+    rx.rows( 1, n-1 ) = x.rows( 0, n-2 );
+    if ( weights.resJumpWeight != 0.0 ) {
+        for ( int i = 0; i + opts.jumpSize < n; i += opts.jumpSize ) {
+            rx.row(i)               += weights.resJumpWeight * x.row(i+opts.jumpSize);
+            rx.row(i+opts.jumpSize) += weights.resJumpWeight * x.row(i);
+        }
+    }
+    return weights.resScale * rx;
+}
+//_____________________________________________________________________________________________________________________
+
 float Esn::GetSpectralRadius() { return weights.opts[1]; }
 //_____________________________________________________________________________________________________________________
 
@@ -182,6 +341,34 @@ int Esn::IsBadInputOrRunOptions()
         isBad = 1;
     }
 
+    if ( ( !opts.freeRunStarts.empty() || opts.resyncInterval != 0 ) && opts.testFilename.empty() ) {
+        std::cerr << "ERROR: -f and -m require test data (-p)" << std::endl;
+        isBad = 1;
+    }
+
+    if ( opts.resyncInterval < 0 ) {
+        std::cerr << "ERROR: re-synchronization interval must not be negative" << std::endl;
+        isBad = 1;
+    }
+
+    if ( opts.resyncInterval != 0 && opts.freeRunStarts.empty() ) {
+        std::cerr << "ERROR: -m requires at least one free-running start (-f)" << std::endl;
+        isBad = 1;
+    }
+
+    // every epoch restarts from the initial state, so it must be warmed up before running free //
+    for ( int start : opts.freeRunStarts ) {
+        if ( start < opts.washout || start >= trialLength ) {
+            std::cerr << "ERROR: free-running start " << start << " must lie between the washout and the end of the epoch" << std::endl;
+            isBad = 1;
+        }
+    }
+
+    if ( !opts.freeRunStarts.empty() && opts.steps < 2 ) {
+        std::cerr << "ERROR: free-running generation requires at least 2 steps" << std::endl;
+        isBad = 1;
+    }
+
     return isBad;
 }
 //_____________________________________________________________________________________________________________________
@@ -263,7 +450,7 @@ int Esn::Run()
     }
 
 	for ( int i=0; i<opts.numNetworks; ++i) {
-		Train();
+		Train( opts.firstNetwork + i );
 	}
 
     WriteParameters();
@@ -273,6 +460,10 @@ int Esn::Run()
         WritePredictions();
     }
 
+    if ( !opts.streamSource.empty() ) {
+        return Stream();
+    }
+
     return 0;
 }
 //_____________________________________________________________________________________________________________________
@@ -286,7 +477,10 @@ void Esn::SetInputScaling( float is )
 
 void Esn::SetSpectralRadius( float sr )
 {
-    weights.resScaled = weights.res * sr /  weights.resMaxEigenvalue;
+    weights.resScale = sr / weights.resMaxEigenvalue;
+    if ( opts.topologyType == randomTopology ) {
+        weights.resScaled = weights.res * weights.resScale;
+    }
     weights.opts[1] = sr;
 }
 //_____________________________________________________________________________________________________________________
@@ -297,23 +491,113 @@ void Esn::SetLeakingRate( float lr ) { weights.opts[2] = lr; }
 void Esn::SetRegularization( float reg ) { weights.opts[3] = reg; }
 //_____________________________________________________________________________________________________________________
 
+void Esn::SparsifyRandom( arma::mat& m, int numZeroElements, uint64_t offset )
+{
+    // zero the elements with the smallest random keys, an order independent shuffle //
+    if ( numZeroElements <= 0 ) {
+        return;
+    }
+    arma::vec keys( m.n_elem );
+    FillRandom( keys, resMaskStream, offset );
+    arma::uvec order = arma::sort_index( keys );
+    m.elem( order.head( numZeroElements ) ).zeros();
+}
+//_____________________________________________________________________________________________________________________
+
+int Esn::Stream()
+{
+    std::unique_ptr< EsnStream > stream = EsnStream::Open( opts.streamSource, true );
+    if ( !stream ) {
+        return 1;
+    }
+
+    std::cout << "Streaming predictions..." << std::flush;
+    weights = weightsBest;
+    float leakingRate = GetLeakingRate();
+    arma::mat outRes = weights.out.cols( 2, opts.reservoirSize+1 );
+
+    // one reservoir state per channel, carried across frames //
+    arma::mat x;
+    arma::mat u;
+    arma::mat frame;
+    arma::mat frameOut;
+    uint32_t numChannels = 0, numSamples = 0;
+    long numFrames = 0;
+    int status = 0;
+    while ( stream->ReadFrameHeader( numChannels, numSamples ) && numSamples > 0 ) {
+        if ( numChannels == 0 || (uint64_t)numChannels * numSamples > EsnStream::maxFrameValues ) {
+            std::cerr << "ERROR: bad frame of " << numChannels << " channels x " << numSamples << " samples" << std::endl;
+            status = 1;
+            break;
+        }
+        if ( x.is_empty() ) {
+            x.ones( opts.reservoirSize, numChannels );
+            u.ones( 2, numChannels );
+        }
+        else if ( numChannels != x.n_cols ) {
+            std::cerr << "ERROR: frame has " << numChannels << " channels, expected " << x.n_cols << std::endl;
+            status = 1;
+            break;
+        }
+
+        // samples are interleaved, so each column of the frame is one timepoint //
+        frame.set_size( numChannels, numSamples );
+        frameOut.set_size( numChannels, numSamples );
+        if ( !stream->Read( frame.memptr(), frame.n_elem * sizeof(double) ) ) {
+            std::cerr << "ERROR: stream ended inside a frame" << std::endl;
+            status = 1;
+            break;
+        }
+        for ( uint32_t i = 0; i < numSamples; ++i ) {
+            u.row(1) = frame.col(i).t();
+            x = (1 - leakingRate)*x + leakingRate * arma::tanh( weights.inScaled * u + GetReservoirActivation( x ) );
+            frameOut.col(i) = ( weights.out(0) + weights.out(1) * u.row(1) + outRes * x ).t();
+        }
+
+        if ( !stream->WriteFrameHeader( numChannels, numSamples ) ||
+             !stream->Write( frameOut.memptr(), frameOut.n_elem * sizeof(double) ) ) {
+            std::cerr << "ERROR: writing predictions to stream" << std::endl;
+            status = 1;
+            break;
+        }
+        ++numFrames;
+    }
+
+    // pass the end of stream on to the reader, also after an error //
+    stream->WriteFrameHeader( x.n_cols, 0 );
+    if ( status == 0 ) {
+        std::cout << " done (" << numFrames << " frames)" << std::flush << std::endl;
+    }
+    return status;
+}
+//_____________________________________________________________________________________________________________________
+
 void Esn::Test()
 {
     std::cout << "Generating predictions... "  << std::flush; 
     weights = weightsBest;
-    DriveNetwork( dataTest, false ); 
+    if ( opts.freeRunStarts.empty() ) {
+        DriveNetwork( dataTest, false ); 
+    }
+    else {
+        DriveNetworkFreeRunning( dataTest );
+    }
     std::cout << " done" << std::flush << std::endl;
 }
 //_____________________________________________________________________________________________________________________
 
-void Esn::Train() {
-    std::cout << "Training network..." << std::endl << std::flush;
+void Esn::Train( int networkIndex ) {
+    std::cout << "Training network " << networkIndex << "..." << std::endl << std::flush;
     
     /// randomly generate network weights ///
-    BuildNetwork();
+    BuildNetwork( networkIndex );
     
     /// drive reservoir and collect States ///
     int dataValSize = dataVal.size();
+    int numValTrials = ( trialLength > 0 ) ? dataValSize / trialLength : 0;
+    if ( dataValSize > 0 ) {
+        valTargetSumSquares = arma::accu( arma::square( dataValTarget - arma::mean(dataValTarget) ) );
+    }
     float is, sr, reg, lr;
     for ( int i=0; i<opts.inputScalings.size(); ++i ) {
         is = opts.inputScalings[i];
@@ -325,23 +609,38 @@ void Esn::Train() {
                 lr = opts.leakingRates[l];
                 SetLeakingRate( lr ); 
                 
-                /// prepare state matrix ///
-                weights.x.set_size( opts.reservoirSize + 2, dataTrain.size() );
-                weights.x.fill( 0.0 );
+                /// accumulate state gram matrix in tiles of kept columns ///
+                int dim = opts.reservoirSize + 2;
+                stateGram.zeros( dim, dim );
+                stateTargetProduct.zeros( dim );
+                arma::mat tile( gramTileSize, dim, arma::fill::zeros );
+                int tileCols = 0;
+                int numKept = 0;
 
                 arma::vec x( opts.reservoirSize, arma::fill::ones );
                 arma::vec vtemp( 2, arma::fill::ones );
                 float vsize = dataTrain.size();
                 for ( int i = 0; i < vsize; ++i ) {
                     vtemp[1] = dataTrain(i);
-                    x = (1 - lr )*x + lr * arma::tanh( weights.inScaled * vtemp + weights.resScaled * x );
-                    weights.x(1,i) = vtemp[1];
-                    weights.x.col(i).subvec(2, weights.x.n_rows-1) = x;
-                } 
+                    x = (1 - lr )*x + lr * arma::tanh( weights.inScaled * vtemp + GetReservoirActivation( x ) );
 
-                for ( int i = vsize - trialLength; i >= 0; i = i - trialLength ) {
-                    weights.x.shed_cols( i+trialLength-opts.steps -1, i+trialLength-1 ); 
-                    weights.x.shed_cols( i+0, i+opts.washout -1 ); 
+                    // skip washout and the last k+1 timepoints of each trial //
+                    int t = i % trialLength;
+                    if ( t < opts.washout || t > trialLength - opts.steps - 2 ) {
+                        continue;
+                    }
+                    tile(tileCols,1) = vtemp[1];
+                    tile.row(tileCols).cols(2, dim-1) = x.t();
+                    if ( ++tileCols == gramTileSize ) {
+                        UpdateStateGram( tile, tileCols, numKept );
+                        numKept += tileCols;
+                        tileCols = 0;
+                    }
+                } 
+                if ( tileCols > 0 ) {
+                    // zero rows add nothing to the gram matrix, so the last tile is padded //
+                    tile.rows( tileCols, gramTileSize-1 ).zeros();
+                    UpdateStateGram( tile, tileCols, numKept );
                 }
             
                 for ( int r=0; r<opts.regularizations.size(); ++r ) {
@@ -349,7 +648,14 @@ void Esn::Train() {
                     SetRegularization( reg );
                     GetOutputWeights();
                     if ( dataVal.size() > 0 ) {
-                        DriveNetwork( dataVal, true );
+                        float errorBound = opts.earlyAbort ? weightsBest.opts[4] : -1;
+                        int numTrialsDriven = DriveNetwork( dataVal, true, errorBound );
+                        if ( numTrialsDriven < numValTrials ) {
+                            std::cout << "  skipped (>= " << errorBound << " after " << numTrialsDriven 
+                                      << "/" << numValTrials << " epochs) : " << lr << "," << sr << "," 
+                                      << is << "," << reg << std::endl << std::flush;
+                            continue;
+                        }
                     }
 
                     if ( dataValSize > 0 ) {
@@ -375,6 +681,38 @@ void Esn::Train() {
 }
 //_____________________________________________________________________________________________________________________
 
+void Esn::UpdateStateGram( const arma::mat& tile, int numRows, int targetOffset )
+{
+    // SYRK-style update of the upper triangle, one block pair per task. The tile is //
+    // time-major, so each block panel is a contiguous range of columns used in place  //
+    int dim = tile.n_cols;
+    int numBlocks = ( dim + gramBlockSize - 1 ) / gramBlockSize;
+    std::vector< std::pair< int, int > > blockPairs;
+    for ( int bc = 0; bc < numBlocks; ++bc ) {
+        for ( int br = 0; br <= bc; ++br ) {
+            blockPairs.emplace_back( br, bc );
+        }
+    }
+
+    int numPairs = blockPairs.size();
+    #pragma omp parallel for schedule(dynamic)
+    for ( int p = 0; p < numPairs; ++p ) {
+        int r0 = blockPairs[p].first * gramBlockSize;
+        int c0 = blockPairs[p].second * gramBlockSize;
+        int r1 = std::min( r0 + gramBlockSize, dim ) - 1;
+        int c1 = std::min( c0 + gramBlockSize, dim ) - 1;
+        const arma::mat panelR( const_cast< double* >( tile.colptr( r0 ) ), tile.n_rows, r1-r0+1, false, true );
+        const arma::mat panelC( const_cast< double* >( tile.colptr( c0 ) ), tile.n_rows, c1-c0+1, false, true );
+        stateGram.submat( r0, c0, r1, c1 ) += panelR.t() * panelC;
+    }
+
+    // rows past numRows are zero padding //
+    arma::vec target( tile.n_rows, arma::fill::zeros );
+    target.head( numRows ) = dataTrainTarget.subvec( targetOffset, targetOffset + numRows - 1 );
+    stateTargetProduct += tile.t() * target;
+}
+//_____________________________________________________________________________________________________________________
+
 void Esn::WriteParameters()
 {
     std::string fn = opts.outputDirectory +  "/esn_parameters.txt";
@@ -384,7 +722,9 @@ void Esn::WriteParameters()
     os << GetBestLeakingRate() << ", ";
     os << GetBestSpectralRadius() << ", ";
     os << GetBestInputScaling() << ", ";
-    os << GetBestRegularization();
+    os << GetBestRegularization() << ", ";
+    os << opts.seed << ", ";
+    os << weightsBest.networkIndex;
     os.close();
 }
 //_____________________________________________________________________________________________________________________
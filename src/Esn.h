@@ -23,6 +23,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <vector>
 #include <memory>
 #include <fstream>
+#include <cstdint>
 
 #include <armadillo>
 
@@ -43,16 +44,29 @@ class Esn
         arma::vec predicted;
         arma::vec yt;
 
+        arma::mat stateGram;
+        arma::vec stateTargetProduct;
+
         EsnOpts opts;
 
         EsnWeights weights;
         EsnWeights weightsBest;
  
+        double valTargetSumSquares = 0.0;
+
         int gridSize;
         int trialLength;
 
-        void  BuildNetwork();
-        void  DriveNetwork( const arma::vec&, bool );
+        static constexpr int gramTileSize  = 256;
+        static constexpr int gramBlockSize = 128;
+
+        void  BuildNetwork( int );
+        void  BuildBlockNetwork();
+        void  BuildCycleNetwork();
+        void  BuildRandomNetwork();
+        int   DriveNetwork( const arma::vec&, bool, float = -1 );
+        void  DriveNetworkFreeRunning( const arma::vec& );
+        void  FillRandom( arma::mat&, uint32_t, uint64_t );
         float GetBestInputScaling();
         float GetBestLeakingRate();
         float GetBestValidationError();
@@ -63,6 +77,7 @@ class Esn
         void  GetOutputWeights();
         void  GetTargetData( arma::vec&, arma::vec&  );
         float GetRegularization();
+        arma::mat GetReservoirActivation( const arma::mat& );
         float GetSpectralRadius();
         float GetValidationError();
         void  LoadAllData();
@@ -73,8 +88,11 @@ class Esn
         void  SetLeakingRate( float );
         void  SetRegularization( float );
         void  SetSpectralRadius( float );
-        void  Train();
+        void  SparsifyRandom( arma::mat&, int, uint64_t );
+        void  Train( int );
+        int   Stream();
         void  Test();
+        void  UpdateStateGram( const arma::mat&, int, int );
         void  WriteParameters();
         int   WritePredictions();
 
@@ -46,14 +46,34 @@ void PrintUsage( const char* argv[] )
 	std::cerr << "  -k : number of steps" << std::endl;
 	std::cerr << "  -w : washout" << std::endl;
 	std::cerr << "  -n : reservoir size" << std::endl;
-	std::cerr << "  -c : connection sparsity" << std::endl;
+	std::cerr << "  -c : connection sparsity (random and block topologies)" << std::endl;
 	std::cerr << "  -x : number of random initializations" << std::endl;
+	std::cerr << "  -g : reservoir topology (random, cycle, jump, block)" << std::endl;
+	std::cerr << "  -j : jump size for the jump topology" << std::endl;
+	std::cerr << "  -q : jump weight relative to the cycle weight for the jump topology (default 0.5)" << std::endl;
+	std::cerr << "  -b : block size for the block topology" << std::endl;
+	std::cerr << "  -e : stop validating a grid point once it cannot beat the best error" << std::endl;
+	std::cerr << "  -f : free-running start timepoint within each test epoch" << std::endl;
+	std::cerr << "  -m : re-synchronize on measured test data every m free-running steps" << std::endl;
+	std::cerr << "  -o : stream source (stdin, unix:<path> or shm:<name>)" << std::endl;
+	std::cerr << "  --seed : random seed (drawn at random if not given)" << std::endl;
+	std::cerr << "  --network : index of the first network (default 0)" << std::endl;
 	std::cerr << "Notes:" << std::endl;
 	std::cerr << "  -the -l -r -s -i options can be specified more than once," << std::endl;
 	std::cerr << "   and validation data will be used to find the optimal value" << std::endl;
 	std::cerr << "   i.e. -l 0.2 -l 0.4 -l 0.6 -l 0.8 etc." << std::endl;
 	std::cerr << "  -can use -a and -b to find optimal parameters, and then" << std::endl;
 	std::cerr << "   use -a and -c to predict" << std::endl;
+	std::cerr << "  -the cycle and jump topologies update the reservoir in O(n)," << std::endl;
+	std::cerr << "   block updates in O(n*b); random is a dense O(n^2) update" << std::endl;
+	std::cerr << "  -with -f the network feeds its own k step predictions back as input" << std::endl;
+	std::cerr << "   from the given timepoint on; -f can be given more than once and every" << std::endl;
+	std::cerr << "   (epoch, start) pair is written as one epoch of the prediction file" << std::endl;
+	std::cerr << "   each epoch is driven from a fresh reservoir, so starts must be >= washout" << std::endl;
+	std::cerr << "  -with -o the trained network predicts framed samples read from the" << std::endl;
+	std::cerr << "   stream and writes prediction frames back (stdout for stdin)" << std::endl;
+	std::cerr << "  -the same --seed and --network give the same network, and" << std::endl;
+	std::cerr << "   esn_parameters.txt records both for the best network" << std::endl;
 	std::cerr << std::endl;	
 }
 //_____________________________________________________________________________________________________________________
@@ -71,8 +91,6 @@ int main ( const int argc, const char* argv[] )
 	}
 
 	Esn esn( esnOpts );
-	esn.Run();
-
-	return 0;
+	return esn.Run();
 }
 //_____________________________________________________________________________________________________________________
\ No newline at end of file
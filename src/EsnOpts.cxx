@@ -18,6 +18,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 
 #include <filesystem>
+#include <random>
 #include "EsnOpts.h"
 #include "cxxopts.hpp"
 
@@ -41,27 +42,73 @@ int EsnOpts::GetInputOpts( const int numInputOpts, const char* inputOpts[] )
 		( "n", "reservoir size",      cxxopts::value( reservoirSize ) )
 		( "c", "connection sparsity", cxxopts::value( sparsity ) )
 		( "x", "number of random initializations", cxxopts::value( numNetworks ) )
+		( "g", "reservoir topology",  cxxopts::value( topology ) )
+		( "j", "jump size",           cxxopts::value( jumpSize ) )
+		( "q", "jump weight",         cxxopts::value( jumpWeight ) )
+		( "b", "block size",          cxxopts::value( blockSize ) )
+		( "e", "early abort of hopeless grid points", cxxopts::value( earlyAbort ) )
+		( "f", "free-running start",  cxxopts::value( freeRunStarts ) )
+		( "m", "re-synchronization interval; measured input every m free-running steps", cxxopts::value( resyncInterval ) )
+		( "o", "stream source",       cxxopts::value( streamSource ) )
+		( "seed", "random seed",      cxxopts::value( seed ) )
+		( "network", "index of the first network", cxxopts::value( firstNetwork ) )
 		;
-		options.parse(numInputOpts, inputOpts);
+		auto result = options.parse(numInputOpts, inputOpts);
+
+		// without --seed, draw one and report it so the run can be repeated //
+		if ( result.count( "seed" ) == 0 ) {
+			std::random_device rd;
+			seed = ( (uint64_t)rd() << 32 ) | rd();
+		}
 	}
 	catch(const cxxopts::OptionException& e) {
 		std::cerr << "ERROR: parsing option " << e.what() << std::endl; return 1;
 	}
 
+	// stdout carries prediction frames when streaming from stdin, so log to stderr //
+	if ( streamSource == "stdin" ) {
+		std::cout.rdbuf( std::cerr.rdbuf() );
+	}
+
 	std::cout << "Network parameters:" << std::endl;
 	PrintFilenameOpts( trainFilename, "train filename");
 	PrintFilenameOpts( testFilename, "test filename");
 	PrintFilenameOpts( validationFilename, "validation filename");
 	PrintFilenameOpts( outputDirectory, "output directory");
+	if ( !streamSource.empty() ) {
+		std::cout << "  stream source -- " << streamSource << std::endl;
+	}
 	if ( CheckAndPrintVectorOpts( inputScalings,   "input scaling"   ) ) { return 1; }
 	if ( CheckAndPrintVectorOpts( spectralRadii,   "spectral radii"  ) ) { return 1; }
 	if ( CheckAndPrintVectorOpts( leakingRates,    "leaking rates"   ) ) { return 1; }
 	if ( CheckAndPrintVectorOpts( regularizations, "regularizations" ) ) { return 1; }
 	if ( CheckAndPrintNumericOpts( steps,   "steps"   ) ) { return 1; }
 	if ( CheckAndPrintNumericOpts( washout, "washout" ) ) { return 1; }
-	if ( CheckAndPrintNumericOpts( sparsity, "sparsity" ) ) { return 1; }
 	if ( CheckAndPrintNumericOpts( reservoirSize, "reservoir size" ) ) { return 1; }
+	if ( CheckTopologyOpts() ) { return 1; }
+
+	// cycle and jump reservoirs have fixed connections, so sparsity does not apply //
+	if ( topologyType != cycleTopology && topologyType != jumpTopology ) {
+		if ( CheckAndPrintNumericOpts( sparsity, "sparsity" ) ) { return 1; }
+	}
 	if ( CheckAndPrintNumericOpts( numNetworks, "number of random initializations" ) ) { return 1; }
+	std::cout << "  seed -- " << seed << std::endl;
+	if ( firstNetwork < 0 ) {
+		std::cerr << "ERROR: network index must not be negative" << std::endl;
+		return 1;
+	}
+	std::cout << "  first network -- " << firstNetwork << std::endl;
+	if ( earlyAbort ) {
+		std::cout << "  early abort -- on" << std::endl;
+	}
+	if ( !freeRunStarts.empty() ) {
+		std::cout << "  free-running starts -- ";
+		for ( int start : freeRunStarts ) {
+			std::cout << start << " ";
+		}
+		std::cout << std::endl;
+		std::cout << "  re-synchronization interval -- " << resyncInterval << std::endl;
+	}
 	if ( CheckFilenameOpts() ) { return 1; }
 	
 	return 0;
@@ -101,8 +148,8 @@ int EsnOpts::CheckFilenameOpts()
 		return 1;
 	}
 
-	if ( validationFilename.empty() && testFilename.empty() ) {
-		std::cerr << "ERROR: must supply -v and/or -p options" << std::endl;
+	if ( validationFilename.empty() && testFilename.empty() && streamSource.empty() ) {
+		std::cerr << "ERROR: must supply -v, -p and/or -o options" << std::endl;
 		return 1;
 	}
 
@@ -114,6 +161,43 @@ int EsnOpts::CheckFilenameOpts()
 	return 0;
 }
 
+int EsnOpts::CheckTopologyOpts()
+{
+	if      ( topology == "random" ) { topologyType = randomTopology; }
+	else if ( topology == "cycle" )  { topologyType = cycleTopology; }
+	else if ( topology == "jump" )   { topologyType = jumpTopology; }
+	else if ( topology == "block" )  { topologyType = blockTopology; }
+	else {
+		std::cerr << "ERROR: unknown reservoir topology " << topology 
+		          << " (expected random, cycle, jump or block)" << std::endl;
+		return 1;
+	}
+	std::cout << "  reservoir topology -- " << topology << std::endl;
+
+	if ( ( topologyType == cycleTopology || topologyType == jumpTopology ) && reservoirSize < 2 ) {
+		std::cerr << "ERROR: cycle and jump topologies require a reservoir size of at least 2" << std::endl;
+		return 1;
+	}
+
+	if ( topologyType == jumpTopology ) {
+		if ( CheckAndPrintNumericOpts( jumpSize, "jump size" ) ) { return 1; }
+		if ( CheckAndPrintNumericOpts( jumpWeight, "jump weight" ) ) { return 1; }
+		if ( jumpSize >= reservoirSize ) {
+			std::cerr << "ERROR: jump size must be smaller than reservoir size" << std::endl;
+			return 1;
+		}
+	}
+	else if ( topologyType == blockTopology ) {
+		if ( CheckAndPrintNumericOpts( blockSize, "block size" ) ) { return 1; }
+		if ( blockSize > reservoirSize ) {
+			std::cerr << "ERROR: block size must not exceed reservoir size" << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
 void EsnOpts::PrintFilenameOpts( const std::string& filename, const std::string& msg )
 {
 	std::cout << "  "  << msg << " -- " 
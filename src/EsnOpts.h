@@ -20,11 +20,21 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef ESNOPTS_H_
 #define ESNOPTS_H_
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
 //_____________________________________________________________________________________________________________________
 
+enum EsnTopology
+{
+	randomTopology,
+	cycleTopology,
+	jumpTopology,
+	blockTopology
+};
+//_____________________________________________________________________________________________________________________
+
 class EsnOpts
 {
 	public:
@@ -33,6 +43,7 @@ class EsnOpts
 		std::string testFilename = "";
 		std::string validationFilename = "";
 		std::string outputDirectory = "";
+		std::string streamSource = "";
 
 		std::vector< float > leakingRates;
 		std::vector< float > regularizations;
@@ -45,6 +56,20 @@ class EsnOpts
 		int   reservoirSize     = 200;
 		int   numNetworks       = 3;
 
+		std::string topology    = "random";
+		EsnTopology topologyType = randomTopology;
+		int   jumpSize          = 10;
+		float jumpWeight        = 0.5;
+		int   blockSize         = 50;
+
+		bool  earlyAbort        = false;
+
+		std::vector< int > freeRunStarts;
+		int   resyncInterval    = 0;
+
+		uint64_t seed           = 0;
+		int   firstNetwork      = 0;
+
 		int GetInputOpts( const int, const char*[] );
 
 	private:
@@ -52,6 +77,7 @@ class EsnOpts
 		int  CheckAndPrintNumericOpts( const float , const std::string&  );
 		int  CheckAndPrintVectorOpts( const std::vector< float >&, const std::string& );
 		int  CheckFilenameOpts();
+		int  CheckTopologyOpts();
 		void PrintFilenameOpts( const std::string&, const std::string& );
 };
 
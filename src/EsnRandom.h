@@ -0,0 +1,83 @@
+/*
+Copyright (C) 2022 Erin Gibson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+//_____________________________________________________________________________________________________________________
+
+
+#ifndef ESNRANDOM_H_
+#define ESNRANDOM_H_
+
+#include <cstdint>
+
+//_____________________________________________________________________________________________________________________
+//
+// Counter-based Philox4x32-10 generator. The value for an element is a pure function of
+// (seed, network, stream, element index), so matrices can be filled in any order or on
+// any number of threads and still come out bit-identical.
+//_____________________________________________________________________________________________________________________
+
+enum EsnRandomStream : uint32_t
+{
+    resValuesStream = 0,
+    resMaskStream   = 1,
+    inValuesStream  = 2
+};
+//_____________________________________________________________________________________________________________________
+
+class EsnRandom
+{
+    private:
+        uint32_t key[2];
+        uint32_t network;
+        uint32_t stream;
+
+    public:
+        EsnRandom( uint64_t seed, uint32_t networkIndex, uint32_t streamIndex )
+        {
+            key[0] = (uint32_t)seed;
+            key[1] = (uint32_t)( seed >> 32 );
+            network = networkIndex;
+            stream = streamIndex;
+        }
+
+        uint64_t Bits( uint64_t index ) const
+        {
+            uint32_t ctr[4] = { (uint32_t)index, (uint32_t)( index >> 32 ), network, stream };
+            uint32_t k[2] = { key[0], key[1] };
+            for ( int r = 0; r < 10; ++r ) {
+                uint64_t p0 = (uint64_t)0xD2511F53 * ctr[0];
+                uint64_t p1 = (uint64_t)0xCD9E8D57 * ctr[2];
+                uint32_t c0 = (uint32_t)( p1 >> 32 ) ^ ctr[1] ^ k[0];
+                uint32_t c2 = (uint32_t)( p0 >> 32 ) ^ ctr[3] ^ k[1];
+                ctr[0] = c0;
+                ctr[1] = (uint32_t)p1;
+                ctr[2] = c2;
+                ctr[3] = (uint32_t)p0;
+                k[0] += 0x9E3779B9;
+                k[1] += 0xBB67AE85;
+            }
+            return ( (uint64_t)ctr[1] << 32 ) | ctr[0];
+        }
+
+        // uniform on [0, 1) with 53 random bits //
+        double Uniform( uint64_t index ) const
+        {
+            return ( Bits( index ) >> 11 ) * ( 1.0 / 9007199254740992.0 );
+        }
+};
+
+#endif
+//_____________________________________________________________________________________________________________________
@@ -0,0 +1,403 @@
+/*
+Copyright (C) 2022 Erin Gibson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+//_____________________________________________________________________________________________________________________
+
+#include "EsnStream.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+//_____________________________________________________________________________________________________________________
+
+static constexpr uint64_t shmRingMagic = 0x45534e52494e4731;
+//_____________________________________________________________________________________________________________________
+
+static bool RemoveSocketFile( const std::string& path )
+{
+    // only ever remove a leftover socket, never a regular file that happens to share the name //
+    struct stat st;
+    if ( lstat( path.c_str(), &st ) < 0 ) {
+        if ( errno == ENOENT ) {
+            return true;
+        }
+        std::cerr << "ERROR: checking " << path << " " << std::strerror( errno ) << std::endl;
+        return false;
+    }
+    if ( !S_ISSOCK( st.st_mode ) ) {
+        std::cerr << "ERROR: " << path << " exists and is not a socket" << std::endl;
+        return false;
+    }
+    if ( unlink( path.c_str() ) < 0 && errno != ENOENT ) {
+        std::cerr << "ERROR: removing " << path << " " << std::strerror( errno ) << std::endl;
+        return false;
+    }
+    return true;
+}
+//_____________________________________________________________________________________________________________________
+
+std::unique_ptr< EsnStream > EsnStream::Open( const std::string& source, bool isServer, int waitSeconds )
+{
+    // a closed peer should end the stream, not the process //
+    std::signal( SIGPIPE, SIG_IGN );
+
+    if ( source == "stdin" ) {
+        return std::make_unique< EsnFdStream >( STDIN_FILENO, STDOUT_FILENO, false );
+    }
+
+    if ( source.rfind( "unix:", 0 ) == 0 ) {
+        std::string path = source.substr( 5 );
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        if ( path.empty() || path.size() >= sizeof( addr.sun_path ) ) {
+            std::cerr << "ERROR: bad unix socket path " << path << std::endl;
+            return nullptr;
+        }
+        std::strncpy( addr.sun_path, path.c_str(), sizeof( addr.sun_path ) - 1 );
+
+        int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+        if ( fd < 0 ) {
+            std::cerr << "ERROR: creating socket " << std::strerror( errno ) << std::endl;
+            return nullptr;
+        }
+
+        if ( isServer ) {
+            if ( !RemoveSocketFile( path ) ) {
+                close( fd );
+                return nullptr;
+            }
+            if ( bind( fd, (sockaddr*)&addr, sizeof( addr ) ) < 0 || listen( fd, 1 ) < 0 ) {
+                std::cerr << "ERROR: listening on " << path << " " << std::strerror( errno ) << std::endl;
+                close( fd );
+                return nullptr;
+            }
+            std::cout << "Waiting for connection on " << path << "..." << std::flush;
+            int conn = accept( fd, nullptr, nullptr );
+            close( fd );
+            bool isRemoved = RemoveSocketFile( path );
+            if ( conn < 0 ) {
+                std::cerr << "ERROR: accepting connection " << std::strerror( errno ) << std::endl;
+                return nullptr;
+            }
+            if ( !isRemoved ) {
+                close( conn );
+                return nullptr;
+            }
+            std::cout << " connected" << std::endl << std::flush;
+            return std::make_unique< EsnFdStream >( conn, conn, true );
+        }
+
+        if ( connect( fd, (sockaddr*)&addr, sizeof( addr ) ) < 0 ) {
+            std::cerr << "ERROR: connecting to " << path << " " << std::strerror( errno ) << std::endl;
+            close( fd );
+            return nullptr;
+        }
+        return std::make_unique< EsnFdStream >( fd, fd, true );
+    }
+
+    if ( source.rfind( "shm:", 0 ) == 0 ) {
+        auto stream = std::make_unique< EsnShmStream >( source.substr( 4 ), isServer, waitSeconds );
+        if ( !stream->IsOpen() ) {
+            return nullptr;
+        }
+        return stream;
+    }
+
+    std::cerr << "ERROR: unknown stream source " << source << std::endl;
+    return nullptr;
+}
+//_____________________________________________________________________________________________________________________
+
+bool EsnStream::ReadFrameHeader( uint32_t& numChannels, uint32_t& numSamples )
+{
+    uint32_t header[2];
+    if ( !Read( header, sizeof( header ) ) ) {
+        return false;
+    }
+    numChannels = header[0];
+    numSamples = header[1];
+    return true;
+}
+//_____________________________________________________________________________________________________________________
+
+bool EsnStream::WriteFrameHeader( uint32_t numChannels, uint32_t numSamples )
+{
+    uint32_t header[2] = { numChannels, numSamples };
+    return Write( header, sizeof( header ) );
+}
+//_____________________________________________________________________________________________________________________
+
+EsnFdStream::EsnFdStream( int in, int out, bool owns ) : fdIn( in ), fdOut( out ), ownsFds( owns ) {}
+//_____________________________________________________________________________________________________________________
+
+EsnFdStream::~EsnFdStream()
+{
+    if ( ownsFds ) {
+        close( fdIn );
+        if ( fdOut != fdIn ) {
+            close( fdOut );
+        }
+    }
+}
+//_____________________________________________________________________________________________________________________
+
+bool EsnFdStream::Read( void* buffer, size_t numBytes )
+{
+    char* p = (char*)buffer;
+    while ( numBytes > 0 ) {
+        ssize_t n = read( fdIn, p, numBytes );
+        if ( n < 0 && errno == EINTR ) {
+            continue;
+        }
+        if ( n <= 0 ) {
+            return false;
+        }
+        p += n;
+        numBytes -= n;
+    }
+    return true;
+}
+//_____________________________________________________________________________________________________________________
+
+bool EsnFdStream::Write( const void* buffer, size_t numBytes )
+{
+    const char* p = (const char*)buffer;
+    while ( numBytes > 0 ) {
+        ssize_t n = write( fdOut, p, numBytes );
+        if ( n < 0 && errno == EINTR ) {
+            continue;
+        }
+        if ( n <= 0 ) {
+            return false;
+        }
+        p += n;
+        numBytes -= n;
+    }
+    return true;
+}
+//_____________________________________________________________________________________________________________________
+
+EsnShmStream::EsnShmStream( const std::string& name, bool isServer, int waitSeconds ) :
+    ringName( name ), ownsRings( isServer ), waitTimeoutSeconds( waitSeconds )
+{
+    mapSize = sizeof( EsnShmRing ) + ringCapacity;
+
+    // the server reads <name>_in and writes <name>_out, the producer the reverse //
+    EsnShmRing* ringA = MapRing( name + "_in", isServer );
+    EsnShmRing* ringB = ringA ? MapRing( name + "_out", isServer ) : nullptr;
+    ringIn  = isServer ? ringA : ringB;
+    ringOut = isServer ? ringB : ringA;
+
+    // register so the other side can tell if this process dies //
+    if ( ringIn )  { ringIn->readerPid.store( getpid(), std::memory_order_relaxed ); }
+    if ( ringOut ) { ringOut->writerPid.store( getpid(), std::memory_order_relaxed ); }
+}
+//_____________________________________________________________________________________________________________________
+
+EsnShmStream::~EsnShmStream()
+{
+    // tell the other side not to wait for this process any longer //
+    if ( ringIn )  { ringIn->closed.store( 1, std::memory_order_release ); }
+    if ( ringOut ) { ringOut->closed.store( 1, std::memory_order_release ); }
+
+    if ( ringIn )  { munmap( ringIn, mapSize ); }
+    if ( ringOut ) { munmap( ringOut, mapSize ); }
+
+    // remove the names; the next server recreates them anyway //
+    if ( ownsRings ) {
+        shm_unlink( ( ringName + "_in" ).c_str() );
+        shm_unlink( ( ringName + "_out" ).c_str() );
+    }
+}
+//_____________________________________________________________________________________________________________________
+
+bool EsnShmStream::IsOpen() { return ringIn != nullptr && ringOut != nullptr; }
+//_____________________________________________________________________________________________________________________
+
+bool EsnShmStream::IsPeerGone( const EsnShmRing* ring, const std::atomic< int32_t >& peerPid,
+                               std::chrono::steady_clock::time_point waitStart )
+{
+    // once the peer is gone the stream stays broken //
+    if ( isPeerGone || ring->closed.load( std::memory_order_acquire ) ) {
+        isPeerGone = true;
+        return true;
+    }
+
+    // a registered peer may legitimately stay idle for as long as it likes while it is alive //
+    int32_t pid = peerPid.load( std::memory_order_relaxed );
+    if ( pid > 0 ) {
+        if ( kill( pid, 0 ) < 0 && errno == ESRCH ) {
+            std::cerr << "ERROR: stream peer " << pid << " exited" << std::endl;
+            isPeerGone = true;
+            return true;
+        }
+        return false;
+    }
+
+    if ( waitTimeoutSeconds > 0 &&
+         std::chrono::steady_clock::now() - waitStart > std::chrono::seconds( waitTimeoutSeconds ) ) {
+        std::cerr << "ERROR: stream peer did not attach within " << waitTimeoutSeconds << " s" << std::endl;
+        isPeerGone = true;
+        return true;
+    }
+    return false;
+}
+//_____________________________________________________________________________________________________________________
+
+EsnShmRing* EsnShmStream::MapRing( const std::string& name, bool isServer )
+{
+    // the server always starts from fresh rings, so a crashed session cannot leave stale data; //
+    // the client waits for the server to create and initialize them                          //
+    int fd = -1;
+    if ( isServer ) {
+        shm_unlink( name.c_str() );
+        fd = shm_open( name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600 );
+        if ( fd >= 0 && ftruncate( fd, mapSize ) < 0 ) {
+            std::cerr << "ERROR: sizing shared memory " << name << " " << std::strerror( errno ) << std::endl;
+            close( fd );
+            shm_unlink( name.c_str() );
+            return nullptr;
+        }
+    }
+    else {
+        auto waitStart = std::chrono::steady_clock::now();
+        struct stat st;
+        while ( ( fd = shm_open( name.c_str(), O_RDWR, 0600 ) ) < 0 || fstat( fd, &st ) < 0 ||
+                (size_t)st.st_size < mapSize ) {
+            if ( fd >= 0 ) {
+                close( fd );
+                fd = -1;
+            }
+            if ( waitTimeoutSeconds > 0 &&
+                 std::chrono::steady_clock::now() - waitStart > std::chrono::seconds( waitTimeoutSeconds ) ) {
+                std::cerr << "ERROR: timed out waiting for shared memory " << name << std::endl;
+                return nullptr;
+            }
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+    }
+    if ( fd < 0 ) {
+        std::cerr << "ERROR: opening shared memory " << name << " " << std::strerror( errno ) << std::endl;
+        return nullptr;
+    }
+
+    void* p = mmap( nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    close( fd );
+    if ( p == MAP_FAILED ) {
+        std::cerr << "ERROR: mapping shared memory " << name << " " << std::strerror( errno ) << std::endl;
+        return nullptr;
+    }
+
+    EsnShmRing* ring = (EsnShmRing*)p;
+    if ( isServer ) {
+        ring->capacity = ringCapacity;
+        ring->head.store( 0, std::memory_order_relaxed );
+        ring->tail.store( 0, std::memory_order_relaxed );
+        ring->closed.store( 0, std::memory_order_relaxed );
+        ring->writerPid.store( 0, std::memory_order_relaxed );
+        ring->readerPid.store( 0, std::memory_order_relaxed );
+        ring->magic.store( shmRingMagic, std::memory_order_release );
+    }
+    else {
+        auto waitStart = std::chrono::steady_clock::now();
+        while ( ring->magic.load( std::memory_order_acquire ) != shmRingMagic ) {
+            if ( waitTimeoutSeconds > 0 &&
+                 std::chrono::steady_clock::now() - waitStart > std::chrono::seconds( waitTimeoutSeconds ) ) {
+                std::cerr << "ERROR: timed out waiting for shared memory " << name << std::endl;
+                munmap( p, mapSize );
+                return nullptr;
+            }
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+    }
+    return ring;
+}
+//_____________________________________________________________________________________________________________________
+
+bool EsnShmStream::Read( void* buffer, size_t numBytes )
+{
+    char* p = (char*)buffer;
+    char* data = (char*)( ringIn + 1 );
+    uint64_t tail = ringIn->tail.load( std::memory_order_relaxed );
+    auto waitStart = std::chrono::steady_clock::now();
+    while ( numBytes > 0 ) {
+        // drain what was written before checking whether the writer is gone //
+        uint64_t available = ringIn->head.load( std::memory_order_acquire ) - tail;
+        if ( available == 0 ) {
+            if ( IsPeerGone( ringIn, ringIn->writerPid, waitStart ) ) {
+                return false;
+            }
+            std::this_thread::sleep_for( std::chrono::microseconds( 20 ) );
+            continue;
+        }
+        uint64_t offset = tail % ringIn->capacity;
+        uint64_t n = std::min( { available, (uint64_t)numBytes, ringIn->capacity - offset } );
+        std::memcpy( p, data + offset, n );
+        p += n;
+        numBytes -= n;
+        tail += n;
+        ringIn->tail.store( tail, std::memory_order_release );
+        waitStart = std::chrono::steady_clock::now();
+    }
+    return true;
+}
+//_____________________________________________________________________________________________________________________
+
+bool EsnShmStream::Write( const void* buffer, size_t numBytes )
+{
+    const char* p = (const char*)buffer;
+    char* data = (char*)( ringOut + 1 );
+    uint64_t head = ringOut->head.load( std::memory_order_relaxed );
+    auto waitStart = std::chrono::steady_clock::now();
+    while ( numBytes > 0 ) {
+        if ( isPeerGone || ringOut->closed.load( std::memory_order_acquire ) ) {
+            isPeerGone = true;
+            return false;
+        }
+        uint64_t space = ringOut->capacity - ( head - ringOut->tail.load( std::memory_order_acquire ) );
+        if ( space == 0 ) {
+            if ( IsPeerGone( ringOut, ringOut->readerPid, waitStart ) ) {
+                return false;
+            }
+            std::this_thread::sleep_for( std::chrono::microseconds( 20 ) );
+            continue;
+        }
+        uint64_t offset = head % ringOut->capacity;
+        uint64_t n = std::min( { space, (uint64_t)numBytes, ringOut->capacity - offset } );
+        std::memcpy( data + offset, p, n );
+        p += n;
+        numBytes -= n;
+        head += n;
+        ringOut->head.store( head, std::memory_order_release );
+        waitStart = std::chrono::steady_clock::now();
+    }
+    return true;
+}
+//_____________________________________________________________________________________________________________________
@@ -0,0 +1,114 @@
+/*
+Copyright (C) 2022 Erin Gibson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+//_____________________________________________________________________________________________________________________
+
+
+#ifndef ESNSTREAM_H_
+#define ESNSTREAM_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+//_____________________________________________________________________________________________________________________
+//
+// Framed sample stream. A frame is a uint32 channel count, a uint32 sample count and then
+// samples*channels doubles, interleaved by sample. A frame with zero samples ends the stream.
+// Sources are "stdin" (frames in on stdin, out on stdout), "unix:<path>" (one connection
+// on a unix domain socket) or "shm:<name>" (shared-memory rings <name>_in and <name>_out).
+// Reads and writes block, so a slow reader holds back the writer. A shm peer that closes or
+// exits makes the blocked call fail, as does one that never attaches within the wait
+// (in seconds, 0 waits forever); a shm client also waits that long for the server's rings.
+//_____________________________________________________________________________________________________________________
+
+class EsnStream
+{
+    public:
+        virtual ~EsnStream() {}
+
+        static constexpr uint64_t maxFrameValues = 1 << 24;
+
+        static constexpr int defaultWaitSeconds = 60;
+
+        static std::unique_ptr< EsnStream > Open( const std::string&, bool, int = defaultWaitSeconds );
+
+        bool ReadFrameHeader( uint32_t&, uint32_t& );
+        bool WriteFrameHeader( uint32_t, uint32_t );
+
+        virtual bool Read( void*, size_t ) = 0;
+        virtual bool Write( const void*, size_t ) = 0;
+};
+//_____________________________________________________________________________________________________________________
+
+class EsnFdStream : public EsnStream
+{
+    private:
+        int  fdIn;
+        int  fdOut;
+        bool ownsFds;
+
+    public:
+        EsnFdStream( int, int, bool );
+        ~EsnFdStream();
+
+        bool Read( void*, size_t ) override;
+        bool Write( const void*, size_t ) override;
+};
+//_____________________________________________________________________________________________________________________
+
+struct EsnShmRing
+{
+    std::atomic< uint64_t > magic;
+    uint64_t capacity;
+    std::atomic< uint64_t > head;
+    std::atomic< uint64_t > tail;
+    std::atomic< uint32_t > closed;
+    std::atomic< int32_t >  writerPid;
+    std::atomic< int32_t >  readerPid;
+};
+//_____________________________________________________________________________________________________________________
+
+class EsnShmStream : public EsnStream
+{
+    private:
+        EsnShmRing* ringIn  = nullptr;
+        EsnShmRing* ringOut = nullptr;
+        size_t      mapSize = 0;
+        std::string ringName;
+        bool        ownsRings;
+        int         waitTimeoutSeconds;
+        std::atomic< bool > isPeerGone{ false };
+
+        bool        IsPeerGone( const EsnShmRing*, const std::atomic< int32_t >&, std::chrono::steady_clock::time_point );
+        EsnShmRing* MapRing( const std::string&, bool );
+
+    public:
+        static constexpr uint64_t ringCapacity = 1 << 20;
+
+        EsnShmStream( const std::string&, bool, int );
+        ~EsnShmStream();
+
+        bool IsOpen();
+        bool Read( void*, size_t ) override;
+        bool Write( const void*, size_t ) override;
+};
+
+#endif
+//_____________________________________________________________________________________________________________________
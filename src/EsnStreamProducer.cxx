@@ -0,0 +1,135 @@
+/*
+Copyright (C) 2022 Erin Gibson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+//_____________________________________________________________________________________________________________________
+
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EsnStream.h"
+
+//_____________________________________________________________________________________________________________________
+
+void PrintUsage( const char* argv[] )
+{
+	std::cerr << std::endl;
+	std::cerr << "Usage: " << std::filesystem::path( argv[0] ).filename().string()
+	          << " <stream> <data filename> <samples per frame> [channels] [wait seconds]" << std::endl;
+	std::cerr << "Notes:" << std::endl;
+	std::cerr << "  -test producer for EsnMain -o; sends the data file (EsnMain input format)" << std::endl;
+	std::cerr << "   as frames, splitting it into equal length channels" << std::endl;
+	std::cerr << "  -stream is stdin (frames written to stdout), unix:<path> or shm:<name>;" << std::endl;
+	std::cerr << "   for unix and shm the prediction frames are read back and counted" << std::endl;
+	std::cerr << "  -with shm, waits up to [wait seconds] (default " << EsnStream::defaultWaitSeconds
+	          << ", 0 for no limit) for EsnMain to finish training and create the rings" << std::endl;
+	std::cerr << std::endl;
+}
+//_____________________________________________________________________________________________________________________
+
+int main ( const int argc, const char* argv[] )
+{
+	if ( argc < 4 ) {
+		PrintUsage( argv );
+		exit( 1 );
+	}
+
+	std::string source = argv[1];
+	std::string fn = argv[2];
+	uint32_t samplesPerFrame = std::stoul( argv[3] );
+	uint32_t numChannels = ( argc > 4 ) ? std::stoul( argv[4] ) : 1;
+	int waitSeconds = ( argc > 5 ) ? std::stoi( argv[5] ) : EsnStream::defaultWaitSeconds;
+	if ( samplesPerFrame == 0 || numChannels == 0 ) {
+		std::cerr << "ERROR: samples per frame and channels must be positive" << std::endl;
+		exit( 1 );
+	}
+	if ( waitSeconds < 0 ) {
+		std::cerr << "ERROR: wait seconds must not be negative" << std::endl;
+		exit( 1 );
+	}
+
+	std::ifstream is( fn, std::ios::binary | std::ios::in );
+	if ( !is ) { std::cerr << "ERROR: opening " << fn << std::endl; exit( 1 ); }
+	double header[2];
+	is.read( (char*)header, sizeof( header ) );
+	size_t numTimepoints = header[0] * header[1];
+	std::vector< double > data( numTimepoints );
+	is.read( (char*)data.data(), numTimepoints * sizeof(double) );
+	if ( !is ) { std::cerr << "ERROR: reading " << fn << std::endl; exit( 1 ); }
+
+	// connect as the client; with stdin the frames simply go to stdout //
+	bool isStdout = ( source == "stdin" );
+	std::unique_ptr< EsnStream > stream = EsnStream::Open( source, false, waitSeconds );
+	if ( !stream ) {
+		exit( 1 );
+	}
+
+	// read predictions back concurrently so a full output ring cannot stall the sender //
+	long numPredicted = 0;
+	std::thread reader;
+	if ( !isStdout ) {
+		reader = std::thread( [&]() {
+			uint32_t c, n;
+			std::vector< double > frame;
+			while ( stream->ReadFrameHeader( c, n ) && n > 0 ) {
+				frame.resize( (size_t)c * n );
+				if ( !stream->Read( frame.data(), frame.size() * sizeof(double) ) ) {
+					break;
+				}
+				numPredicted += n;
+			}
+		} );
+	}
+
+	int status = 0;
+	auto start = std::chrono::steady_clock::now();
+	size_t channelLength = numTimepoints / numChannels;
+	std::vector< double > frame( (size_t)samplesPerFrame * numChannels );
+	for ( size_t t0 = 0; t0 < channelLength; t0 += samplesPerFrame ) {
+		uint32_t n = std::min( (size_t)samplesPerFrame, channelLength - t0 );
+		for ( uint32_t i = 0; i < n; ++i ) {
+			for ( uint32_t c = 0; c < numChannels; ++c ) {
+				frame[ i*numChannels + c ] = data[ c*channelLength + t0 + i ];
+			}
+		}
+		if ( !stream->WriteFrameHeader( numChannels, n ) ||
+		     !stream->Write( frame.data(), (size_t)n * numChannels * sizeof(double) ) ) {
+			std::cerr << "ERROR: writing frame" << std::endl;
+			status = 1;
+			break;
+		}
+	}
+	stream->WriteFrameHeader( numChannels, 0 );
+
+	if ( reader.joinable() ) {
+		reader.join();
+		double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+		std::cerr << numPredicted << " of " << channelLength << " samples x " << numChannels
+		          << " channels predicted in " << seconds << " s" << std::endl;
+		if ( numPredicted != (long)channelLength ) {
+			status = 1;
+		}
+	}
+
+	return status;
+}
+//_____________________________________________________________________________________________________________________
@@ -0,0 +1,95 @@
+/*
+Copyright (C) 2022 Erin Gibson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+//_____________________________________________________________________________________________________________________
+
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+//_____________________________________________________________________________________________________________________
+
+void PrintUsage( const char* argv[] )
+{
+	std::cerr << std::endl;
+	std::cerr << "Usage: " << std::filesystem::path( argv[0] ).filename().string()
+	          << " <output filename> <trial length> <number of trials> [seed]" << std::endl;
+	std::cerr << "Notes:" << std::endl;
+	std::cerr << "  -writes epoched, eeg-like test data (mixed oscillations plus noise," << std::endl;
+	std::cerr << "   scaled to lie between 0 and 1) in the EsnMain input format" << std::endl;
+	std::cerr << std::endl;
+}
+//_____________________________________________________________________________________________________________________
+
+int main ( const int argc, const char* argv[] )
+{
+	if ( argc < 4 ) {
+		PrintUsage( argv );
+		exit( 1 );
+	}
+
+	std::string fn = argv[1];
+	int trialLength = std::stoi( argv[2] );
+	int numTrials = std::stoi( argv[3] );
+	unsigned int seed = ( argc > 4 ) ? std::stoul( argv[4] ) : 1;
+	if ( trialLength <= 0 || numTrials <= 0 ) {
+		std::cerr << "ERROR: trial length and number of trials must be positive" << std::endl;
+		exit( 1 );
+	}
+
+	std::ofstream os( fn, std::ios::binary | std::ios::out );
+	if ( !os ) { std::cerr << "ERROR: opening " << fn << std::endl; exit( 1 ); }
+
+	double d = trialLength;
+	os.write( (char*)&d, sizeof(double) );
+	d = numTrials;
+	os.write( (char*)&d, sizeof(double) );
+
+	// delta, theta, alpha and beta-like components at a 500 Hz sampling rate //
+	const double freqs[4] = { 2.0, 6.0, 10.0, 20.0 };
+	const double amps[4]  = { 1.0, 0.5, 0.7, 0.2 };
+	const double pi = std::acos( -1.0 );
+	const double ampSum = amps[0] + amps[1] + amps[2] + amps[3];
+
+	std::mt19937 gen( seed );
+	std::uniform_real_distribution<double> phaseDist( 0.0, 2.0*pi );
+	std::normal_distribution<double> noiseDist( 0.0, 0.05 );
+	for ( int e = 0; e < numTrials; ++e ) {
+		double phases[4];
+		for ( int c = 0; c < 4; ++c ) {
+			phases[c] = phaseDist( gen );
+		}
+		for ( int i = 0; i < trialLength; ++i ) {
+			double t = i / 500.0;
+			double v = 0.0;
+			for ( int c = 0; c < 4; ++c ) {
+				v += amps[c] * std::sin( 2.0*pi*freqs[c]*t + phases[c] );
+			}
+			v += noiseDist( gen );
+			d = std::min( 1.0, std::max( 0.0, 0.5 + 0.4 * v / ampSum ) );
+			os.write( (char*)&d, sizeof(double) );
+		}
+	}
+	os.close();
+
+	return 0;
+}
+//_____________________________________________________________________________________________________________________
@@ -32,10 +32,13 @@ class EsnWeights
         arma::mat out;
         arma::mat res;
         arma::mat resScaled;
+        arma::field< arma::mat > resBlocks;
         arma::mat xTrained;
-        arma::mat x;
 
         float resMaxEigenvalue;
+        float resJumpWeight = 0.0;
+        float resScale      = 1.0;
+        int   networkIndex  = 0;
         float opts[5] = { -1.0, -1.0, -1.0, -1.0, -1.0};
 };
 